@@ -15,4 +15,5 @@
 #ifndef INCLUDE_SST_RACKHELPERS_H
 #define INCLUDE_SST_RACKHELPERS_H
 #include "rackhelpers/json.h"
+#include "rackhelpers/patch_plan.h"
 #endif
@@ -15,11 +15,246 @@
 #ifndef INCLUDE_SST_RACKHELPERS_JSON_H
 #define INCLUDE_SST_RACKHELPERS_JSON_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <type_traits>
 
 namespace sst::rackhelpers::json
 {
+/*
+ * SerializationProfiler answers "which module types make my patch slow to load and
+ * save". Put a Scope in dataFromJson / dataToJson (or wherever you serialize) with a
+ * module type name, and while the profiler is enabled it records time, JSON bytes,
+ * keys, jsonSafeGet lookups and misses, and jsonSafeSet calls, aggregated by type.
+ * Direct convertFromJson / convertToJson calls are not counted.
+ *
+ * When it is disabled a Scope costs one atomic load and the get/set helpers one
+ * thread local pointer check. Measuring bytes dumps the JSON, so only enable it
+ * while profiling.
+ */
+struct SerializationProfiler
+{
+    struct Stats
+    {
+        uint64_t loads{0}, loadBytes{0}, loadKeys{0}, lookups{0}, lookupMisses{0};
+        uint64_t saves{0}, saveBytes{0}, saveKeys{0}, sets{0};
+        double loadMicros{0}, saveMicros{0};
+    };
+
+    static SerializationProfiler &get()
+    {
+        static SerializationProfiler p;
+        return p;
+    }
+
+    std::atomic<bool> enabled{false};
+    std::mutex statsMutex;
+    std::map<std::string, Stats> stats;
+
+    void setEnabled(bool e) { enabled.store(e); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> g(statsMutex);
+        stats.clear();
+    }
+
+    static uint64_t countKeys(json_t *o)
+    {
+        if (!o)
+            return 0;
+        uint64_t res{0};
+        if (json_is_object(o))
+        {
+            const char *k;
+            json_t *v;
+            json_object_foreach(o, k, v)
+            {
+                res += 1 + countKeys(v);
+            }
+        }
+        else if (json_is_array(o))
+        {
+            size_t i;
+            json_t *v;
+            json_array_foreach(o, i, v)
+            {
+                res += countKeys(v);
+            }
+        }
+        return res;
+    }
+
+    static uint64_t countBytes(json_t *o)
+    {
+        if (!o)
+            return 0;
+        auto d = json_dumps(o, JSON_COMPACT);
+        if (!d)
+            return 0;
+        auto res = strlen(d);
+        free(d);
+        return res;
+    }
+
+    struct Scope
+    {
+        enum Direction
+        {
+            LOAD,
+            SAVE
+        };
+
+        static Scope *&current()
+        {
+            static thread_local Scope *c{nullptr};
+            return c;
+        }
+
+        bool active{false};
+        std::string moduleType;
+        Direction direction{LOAD};
+        json_t *root{nullptr};
+        uint64_t lookups{0}, lookupMisses{0}, sets{0};
+        std::chrono::steady_clock::time_point start;
+        Scope *prior{nullptr};
+
+        // For a save, the root usually doesn't exist yet, so call setRoot before returning
+        Scope(const std::string &type, Direction d, json_t *r = nullptr)
+        {
+            if (!SerializationProfiler::get().isEnabled())
+                return;
+            active = true;
+            moduleType = type;
+            direction = d;
+            root = r;
+            prior = current();
+            current() = this;
+            start = std::chrono::steady_clock::now();
+        }
+
+        void setRoot(json_t *r) { root = r; }
+
+        ~Scope()
+        {
+            if (!active)
+                return;
+            auto micros = std::chrono::duration<double, std::micro>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+            current() = prior;
+
+            auto keys = countKeys(root);
+            auto bytes = countBytes(root);
+
+            auto &p = SerializationProfiler::get();
+            std::lock_guard<std::mutex> g(p.statsMutex);
+            auto &st = p.stats[moduleType];
+            if (direction == LOAD)
+            {
+                st.loads++;
+                st.loadBytes += bytes;
+                st.loadKeys += keys;
+                st.lookups += lookups;
+                st.lookupMisses += lookupMisses;
+                st.loadMicros += micros;
+            }
+            else
+            {
+                st.saves++;
+                st.saveBytes += bytes;
+                st.saveKeys += keys;
+                st.sets += sets;
+                st.saveMicros += micros;
+            }
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+    // The caller owns the result and must json_decref it
+    json_t *toJson()
+    {
+        std::lock_guard<std::mutex> g(statsMutex);
+        auto res = json_object();
+        for (const auto &[k, st] : stats)
+        {
+            auto o = json_object();
+            json_object_set_new(o, "loads", json_integer(st.loads));
+            json_object_set_new(o, "loadBytes", json_integer(st.loadBytes));
+            json_object_set_new(o, "loadKeys", json_integer(st.loadKeys));
+            json_object_set_new(o, "lookups", json_integer(st.lookups));
+            json_object_set_new(o, "lookupMisses", json_integer(st.lookupMisses));
+            json_object_set_new(o, "loadMicros", json_real(st.loadMicros));
+            json_object_set_new(o, "saves", json_integer(st.saves));
+            json_object_set_new(o, "saveBytes", json_integer(st.saveBytes));
+            json_object_set_new(o, "saveKeys", json_integer(st.saveKeys));
+            json_object_set_new(o, "sets", json_integer(st.sets));
+            json_object_set_new(o, "saveMicros", json_real(st.saveMicros));
+            json_object_set_new(res, k.c_str(), o);
+        }
+        return res;
+    }
+
+    std::string toCSV()
+    {
+        std::lock_guard<std::mutex> g(statsMutex);
+        std::string res = "moduleType,loads,loadBytes,loadKeys,lookups,lookupMisses,loadMicros,"
+                          "saves,saveBytes,saveKeys,sets,saveMicros\n";
+        for (const auto &[k, st] : stats)
+        {
+            char line[512];
+            snprintf(line, 512, ",%llu,%llu,%llu,%llu,%llu,%.1f,%llu,%llu,%llu,%llu,%.1f\n",
+                     (unsigned long long)st.loads, (unsigned long long)st.loadBytes,
+                     (unsigned long long)st.loadKeys, (unsigned long long)st.lookups,
+                     (unsigned long long)st.lookupMisses, st.loadMicros,
+                     (unsigned long long)st.saves, (unsigned long long)st.saveBytes,
+                     (unsigned long long)st.saveKeys, (unsigned long long)st.sets,
+                     st.saveMicros);
+            // module type names can contain commas and quotes, so quote them and
+            // double any embedded quote
+            std::string quoted;
+            for (auto c : k)
+            {
+                if (c == '"')
+                    quoted += '"';
+                quoted += c;
+            }
+            res += "\"" + quoted + "\"" + line;
+        }
+        return res;
+    }
+
+    bool writeJson(const std::string &path)
+    {
+        auto j = toJson();
+        auto res = json_dump_file(j, path.c_str(), JSON_INDENT(2) | JSON_SORT_KEYS);
+        json_decref(j);
+        return res == 0;
+    }
+
+    bool writeCSV(const std::string &path)
+    {
+        auto csv = toCSV();
+        auto f = fopen(path.c_str(), "w");
+        if (!f)
+            return false;
+        auto ok = fwrite(csv.data(), 1, csv.size(), f) == csv.size();
+        fclose(f);
+        return ok;
+    }
+};
+
 template <typename T> inline std::optional<T> convertFromJson(json_t *o) { return {}; }
 template <> inline std::optional<std::string> convertFromJson<std::string>(json_t *o)
 {
@@ -81,12 +316,79 @@ template <> inline std::optional<double> convertFromJson<double>(json_t *o)
 
 template <typename T> inline std::optional<T> jsonSafeGet(json_t *rootJ, const std::string key)
 {
+    auto scope = SerializationProfiler::Scope::current();
     auto val = json_object_get(rootJ, key.c_str());
     if (!val)
     {
+        if (scope)
+        {
+            scope->lookups++;
+            scope->lookupMisses++;
+        }
         return {};
     }
-    return convertFromJson<T>(val);
+    auto res = convertFromJson<T>(val);
+    if (scope)
+    {
+        scope->lookups++;
+        if (!res.has_value())
+            scope->lookupMisses++;
+    }
+    return res;
+}
+
+template <typename T> struct unsupportedJsonType : std::false_type
+{
+};
+
+// Only the specializations below write anything, so fail at compile time rather than
+// silently dropping a value on save
+template <typename T> inline json_t *convertToJson(const T &v)
+{
+    static_assert(unsupportedJsonType<T>::value, "convertToJson: unsupported type");
+    return nullptr;
+}
+template <> inline json_t *convertToJson<std::string>(const std::string &v)
+{
+    return json_string(v.c_str());
+}
+template <> inline json_t *convertToJson<bool>(const bool &v) { return json_boolean(v); }
+template <> inline json_t *convertToJson<int>(const int &v) { return json_integer(v); }
+// long and long long between them cover int64_t (module ids) on every platform
+template <> inline json_t *convertToJson<long>(const long &v) { return json_integer(v); }
+template <> inline json_t *convertToJson<long long>(const long long &v)
+{
+    return json_integer(v);
+}
+template <> inline json_t *convertToJson<float>(const float &v) { return json_real(v); }
+template <> inline json_t *convertToJson<double>(const double &v) { return json_real(v); }
+
+// Arrays and pointers go to the char * overloads below rather than this template
+template <typename T, typename = std::enable_if_t<!std::is_array_v<T> && !std::is_pointer_v<T>>>
+inline bool jsonSafeSet(json_t *rootJ, const std::string key, const T &value)
+{
+    auto val = convertToJson<T>(value);
+    if (!rootJ || !val)
+    {
+        if (val)
+            json_decref(val);
+        return false;
+    }
+    if (auto scope = SerializationProfiler::Scope::current())
+        scope->sets++;
+    return json_object_set_new(rootJ, key.c_str(), val) == 0;
+}
+
+inline bool jsonSafeSet(json_t *rootJ, const std::string key, const char *value)
+{
+    if (!value)
+        return false;
+    return jsonSafeSet<std::string>(rootJ, key, std::string(value));
+}
+
+inline bool jsonSafeSet(json_t *rootJ, const std::string key, char *value)
+{
+    return jsonSafeSet(rootJ, key, static_cast<const char *>(value));
 }
 } // namespace sst::rackhelpers::json
 #endif
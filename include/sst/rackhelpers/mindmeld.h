@@ -0,0 +1,107 @@
+/*
+ * sst-rackhelpers - a Surge Synth Team product
+ *
+ * A set of header-only utilities we use when making stuff for VCV Rack
+ *
+ * Copyright 2019 - 2023, Various authors, as described in the github
+ * transaction log.
+ *
+ * sst-rackhelpers is released under the MIT license, found in the file
+ * "LICENSE.md" in this repository.
+ *
+ * All source for sst-rackhelpers is available at
+ * https://github.com/surge-synthesizer/sst-rackhelpers
+ */
+
+#ifndef INCLUDE_SST_RACKHELPERS_MINDMELD_H
+#define INCLUDE_SST_RACKHELPERS_MINDMELD_H
+
+/*
+ * Finding MindMeld MixMaster and AuxSpander instances and their port layout. These
+ * are split out of module_connector.h so the ui helpers can use them without pulling
+ * in all of the connection code.
+ */
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace sst::rackhelpers::module_connector
+{
+inline std::vector<rack::Module *> findMixMasters()
+{
+    auto mids = rack::contextGet()->engine->getModuleIds();
+    std::vector<rack::Module *> result;
+    for (auto mid : mids)
+    {
+        auto mod = rack::contextGet()->engine->getModule(mid);
+        if (mod)
+        {
+            auto nm = mod->getModel()->name;
+            auto pn = mod->getModel()->plugin->name;
+            if ((nm == "MixMaster" || nm == "MixMasterJr") && (pn == "MindMeld"))
+            {
+                result.push_back(mod);
+            }
+        }
+    }
+    return result;
+}
+
+inline int mixMasterNumInputs(rack::Module *mm)
+{
+    assert(mm->getModel()->plugin->name == "MindMeld");
+    if (mm->getModel()->name == "MixMaster")
+        return 16;
+    if (mm->getModel()->name == "MixMasterJr")
+        return 8;
+    return 0;
+}
+
+inline int auxSpanderNumInputs(rack::Module *mm)
+{
+    assert(mm->getModel()->plugin->name == "MindMeld");
+    if (mm->getModel()->name == "AuxSpander")
+        return 4;
+    if (mm->getModel()->name == "AuxSpanderJr")
+        return 4;
+    return 0;
+}
+
+inline std::pair<int, int> mixMasterInput(rack::Module *mm, int channel)
+{
+    return {channel * 2, channel * 2 + 1};
+}
+
+inline std::pair<int, int> auxSpanderReturn(rack::Module *mm, int channel)
+{
+    return {channel * 2, channel * 2 + 1};
+}
+
+inline std::pair<int, int> auxSpanderSend(rack::Module *mm, int channel)
+{
+    // oh marc why are your sends not interleaved like your returns?
+    return {channel, channel + 4};
+}
+
+inline std::vector<rack::Module *> findAuxSpanders()
+{
+    auto mids = rack::contextGet()->engine->getModuleIds();
+    std::vector<rack::Module *> result;
+    for (auto mid : mids)
+    {
+        auto mod = rack::contextGet()->engine->getModule(mid);
+        if (mod)
+        {
+            auto nm = mod->getModel()->name;
+            auto pn = mod->getModel()->plugin->name;
+            if ((nm == "AuxSpander" || nm == "AuxSpanderJr") && (pn == "MindMeld"))
+            {
+                result.push_back(mod);
+            }
+        }
+    }
+    return result;
+}
+} // namespace sst::rackhelpers::module_connector
+#endif // INCLUDE_SST_RACKHELPERS_MINDMELD_H
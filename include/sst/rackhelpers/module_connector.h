@@ -16,10 +16,17 @@
 #ifndef INCLUDE_SST_RACKHELPERS_MODULE_CONNECTOR_H
 #define INCLUDE_SST_RACKHELPERS_MODULE_CONNECTOR_H
 
+#include "mindmeld.h"
 #include "neighbor_connectable.h"
+#include "patch_plan.h"
+#include "text_layout.h"
 
+#include <algorithm>
 #include <cassert>
+#include <map>
 #include <optional>
+#include <set>
+#include <vector>
 
 namespace sst::rackhelpers::module_connector
 {
@@ -40,11 +47,20 @@ struct MultiColorMenuItem : rack::MenuItem
         if (parentMenu && parentMenu->activeEntry == this)
             state = BND_ACTIVE;
 
-        // Main text and background
+        // Background from blendish, with no label, and text through the layout cache
+        auto theme = bndGetTheme();
         if (!disabled)
-            bndMenuItem(args.vg, 0.0, 0.0, box.size.x, box.size.y, state, -1, text.c_str());
+        {
+            bndMenuItem(args.vg, 0.0, 0.0, box.size.x, box.size.y, state, -1, nullptr);
+            ui::TextLayoutCache::drawBndLabel(args.vg, text,
+                                              state == BND_DEFAULT
+                                                  ? theme->menuItemTheme.textColor
+                                                  : theme->menuItemTheme.textSelectedColor);
+        }
         else
-            bndMenuLabel(args.vg, 0.0, 0.0, box.size.x, box.size.y, -1, text.c_str());
+        {
+            ui::TextLayoutCache::drawBndLabel(args.vg, text, theme->menuTheme.textColor);
+        }
 
         bool halfMoons = false, halfTop = false;
         if (rack::settings::cableColors.size() > maxCircles)
@@ -137,7 +153,12 @@ struct MultiColorMenuItem : rack::MenuItem
 
     void step() override
     {
-        rack::MenuItem::step();
+        // This is rack::MenuItem::step but with the label widths from the layout cache
+        auto vg = APP->window->vg;
+        box.size.x = ui::TextLayoutCache::labelWidth(vg, text) + 10.0;
+        if (!rightText.empty())
+            box.size.x += ui::TextLayoutCache::labelWidth(vg, rightText) - 10.0;
+        rack::Widget::step();
         box.size.x += colBoxSz * std::min(rack::settings::cableColors.size(), maxCircles);
     }
 
@@ -167,111 +188,299 @@ struct MultiColorMenuItem : rack::MenuItem
     }
 };
 
-inline std::vector<rack::Module *> findMixMasters()
+inline void makeCableBetween(rack::Module *inModule, int inId, rack::Module *outModule, int outId,
+                             NVGcolor col, rack::history::ComplexAction *complexAction = nullptr)
 {
-    auto mids = rack::contextGet()->engine->getModuleIds();
-    std::vector<rack::Module *> result;
-    for (auto mid : mids)
+    // Create cable attached to cloned this->moduleWidget's input
+    rack::engine::Cable *clonedCable = new rack::engine::Cable;
+    clonedCable->inputModule = inModule;
+    clonedCable->inputId = inId;
+    clonedCable->outputModule = outModule;
+    clonedCable->outputId = outId;
+    APP->engine->addCable(clonedCable);
+
+    rack::app::CableWidget *clonedCw = new rack::app::CableWidget;
+    clonedCw->setCable(clonedCable);
+    clonedCw->color = col;
+    APP->scene->rack->addCable(clonedCw);
+
+    // history::CableAdd
+    rack::history::CableAdd *hca = new rack::history::CableAdd;
+    hca->setCable(clonedCw);
+    if (complexAction)
     {
-        auto mod = rack::contextGet()->engine->getModule(mid);
-        if (mod)
-        {
-            auto nm = mod->getModel()->name;
-            auto pn = mod->getModel()->plugin->name;
-            if ((nm == "MixMaster" || nm == "MixMasterJr") && (pn == "MindMeld"))
-            {
-                result.push_back(mod);
-            }
-        }
+        complexAction->push(hca);
+    }
+    else
+    {
+        APP->history->push(hca);
     }
-    return result;
 }
 
-inline int mixMasterNumInputs(rack::Module *mm)
+/*
+ * The patch building functions come in two layers. planFromEngine, prepareRoutes and
+ * addRoutesToEngine only touch the engine, so you can route a whole generated patch
+ * with no widgets or history at all. addCableWidgets (or addMissingCableWidgets) then
+ * creates the cable widgets and undo entries in bulk, whenever you want the UI to
+ * catch up.
+ */
+inline patch_plan::PatchPlan planFromEngine()
 {
-    assert(mm->getModel()->plugin->name == "MindMeld");
-    if (mm->getModel()->name == "MixMaster")
-        return 16;
-    if (mm->getModel()->name == "MixMasterJr")
-        return 8;
-    return 0;
+    patch_plan::PatchPlan plan;
+    for (auto mid : APP->engine->getModuleIds())
+    {
+        auto mod = APP->engine->getModule(mid);
+        if (mod)
+            plan.addModule({mid, (int)mod->inputs.size(), (int)mod->outputs.size(),
+                            mod->getModel()->name});
+    }
+    for (auto cid : APP->engine->getCableIds())
+    {
+        auto cable = APP->engine->getCable(cid);
+        if (cable && cable->inputModule)
+            plan.markInputUsed(cable->inputModule->id, cable->inputId);
+    }
+    return plan;
 }
 
-inline int auxSpanderNumInputs(rack::Module *mm)
+/*
+ * The result of routing into the engine. cables[i] came from routes[routeIndex[i]], and
+ * routes which were not added (missing module, port out of range, input already
+ * taken) are returned in skipped rather than dropped silently.
+ */
+struct EngineRouting
 {
-    assert(mm->getModel()->plugin->name == "MindMeld");
-    if (mm->getModel()->name == "AuxSpander")
-        return 4;
-    if (mm->getModel()->name == "AuxSpanderJr")
-        return 4;
-    return 0;
-}
+    std::vector<rack::engine::Cable *> cables;
+    std::vector<size_t> routeIndex;
+    std::vector<patch_plan::Route> skipped;
+};
 
-inline std::pair<int, int> mixMasterInput(rack::Module *mm, int channel)
+// Resolve modules, range check ports and allocate the cables without touching the engine
+inline EngineRouting prepareRoutes(const std::vector<patch_plan::Route> &routes)
 {
-    return {channel * 2, channel * 2 + 1};
+    EngineRouting res;
+    res.cables.reserve(routes.size());
+    res.routeIndex.reserve(routes.size());
+    for (size_t i = 0; i < routes.size(); ++i)
+    {
+        const auto &r = routes[i];
+        auto outModule = APP->engine->getModule(r.outModule);
+        auto inModule = APP->engine->getModule(r.inModule);
+        if (!outModule || !inModule || r.outId < 0 || r.outId >= (int)outModule->outputs.size() ||
+            r.inId < 0 || r.inId >= (int)inModule->inputs.size())
+        {
+            res.skipped.push_back(r);
+            continue;
+        }
+
+        auto cable = new rack::engine::Cable;
+        cable->inputModule = inModule;
+        cable->inputId = r.inId;
+        cable->outputModule = outModule;
+        cable->outputId = r.outId;
+        res.cables.push_back(cable);
+        res.routeIndex.push_back(i);
+    }
+    return res;
 }
 
-inline std::pair<int, int> auxSpanderReturn(rack::Module *mm, int channel)
+// Add prepared cables to the engine, skipping (and freeing) any whose input is taken
+inline void addPreparedRoutesToEngine(EngineRouting &prepared)
 {
-    return {channel * 2, channel * 2 + 1};
+    std::set<std::pair<rack::Module *, int>> added;
+    size_t kept{0};
+    for (size_t i = 0; i < prepared.cables.size(); ++i)
+    {
+        auto cable = prepared.cables[i];
+        if (cable->inputModule->inputs[cable->inputId].isConnected() ||
+            !added.insert({cable->inputModule, cable->inputId}).second)
+        {
+            prepared.skipped.push_back({cable->outputModule->id, cable->outputId,
+                                        cable->inputModule->id, cable->inputId});
+            delete cable;
+            continue;
+        }
+        APP->engine->addCable(cable);
+        prepared.cables[kept] = cable;
+        prepared.routeIndex[kept] = prepared.routeIndex[i];
+        kept++;
+    }
+    prepared.cables.resize(kept);
+    prepared.routeIndex.resize(kept);
 }
 
-inline std::pair<int, int> auxSpanderSend(rack::Module *mm, int channel)
+inline EngineRouting addRoutesToEngine(const std::vector<patch_plan::Route> &routes)
 {
-    // oh marc why are your sends not interleaved like your returns?
-    return {channel, channel + 4};
+    auto res = prepareRoutes(routes);
+    addPreparedRoutesToEngine(res);
+    return res;
 }
 
-inline std::vector<rack::Module *> findAuxSpanders()
+// A plan which doesn't validate is rejected whole, with every route in skipped
+inline EngineRouting addRoutesToEngine(const patch_plan::PatchPlan &plan)
 {
-    auto mids = rack::contextGet()->engine->getModuleIds();
-    std::vector<rack::Module *> result;
-    for (auto mid : mids)
+    if (!plan.validate().empty())
     {
-        auto mod = rack::contextGet()->engine->getModule(mid);
-        if (mod)
-        {
-            auto nm = mod->getModel()->name;
-            auto pn = mod->getModel()->plugin->name;
-            if ((nm == "AuxSpander" || nm == "AuxSpanderJr") && (pn == "MindMeld"))
-            {
-                result.push_back(mod);
-            }
-        }
+        EngineRouting res;
+        res.skipped = plan.routes;
+        return res;
     }
-    return result;
+    return addRoutesToEngine(plan.routes);
 }
 
-inline void makeCableBetween(rack::Module *inModule, int inId, rack::Module *outModule, int outId,
-                             NVGcolor col, rack::history::ComplexAction *complexAction = nullptr)
+// Like makeCableBetween, with no complexAction the undo entry goes straight to history
+inline void addCableWidgets(const std::vector<rack::engine::Cable *> &cables,
+                            const std::vector<NVGcolor> &colors,
+                            rack::history::ComplexAction *complexAction = nullptr)
 {
-    // Create cable attached to cloned this->moduleWidget's input
-    rack::engine::Cable *clonedCable = new rack::engine::Cable;
-    clonedCable->inputModule = inModule;
-    clonedCable->inputId = inId;
-    clonedCable->outputModule = outModule;
-    clonedCable->outputId = outId;
-    APP->engine->addCable(clonedCable);
+    if (cables.empty())
+        return;
 
-    rack::app::CableWidget *clonedCw = new rack::app::CableWidget;
-    clonedCw->setCable(clonedCable);
-    clonedCw->color = col;
-    APP->scene->rack->addCable(clonedCw);
+    bool ownAction{false};
+    if (!complexAction)
+    {
+        complexAction = new rack::history::ComplexAction;
+        complexAction->name = "add cables";
+        ownAction = true;
+    }
 
-    // history::CableAdd
-    rack::history::CableAdd *hca = new rack::history::CableAdd;
-    hca->setCable(clonedCw);
-    if (complexAction)
+    for (size_t i = 0; i < cables.size(); ++i)
     {
+        auto cw = new rack::app::CableWidget;
+        cw->setCable(cables[i]);
+        cw->color = i < colors.size() ? colors[i] : APP->scene->rack->getNextCableColor();
+        APP->scene->rack->addCable(cw);
+
+        rack::history::CableAdd *hca = new rack::history::CableAdd;
+        hca->setCable(cw);
         complexAction->push(hca);
     }
-    else
+
+    if (ownAction)
+        APP->history->push(complexAction);
+}
+
+// Give every engine cable which doesn't have a widget yet one, as a single undo step
+inline void addMissingCableWidgets(const std::string &name = "add cables")
+{
+    std::vector<rack::engine::Cable *> cables;
+    for (auto cid : APP->engine->getCableIds())
     {
-        APP->history->push(hca);
+        if (!APP->scene->rack->getCable(cid))
+            cables.push_back(APP->engine->getCable(cid));
     }
+    if (cables.empty())
+        return;
+
+    rack::history::ComplexAction *complexAction = new rack::history::ComplexAction;
+    complexAction->name = name;
+    addCableWidgets(cables, {}, complexAction);
+    APP->history->push(complexAction);
 }
 
+/*
+ * CableBatch collects a set of cable removals and connections and applies them together.
+ * Everything is looked up and allocated first, then the removals and engine additions
+ * run back to back, the new widgets are created after, and the whole lot lands in the
+ * undo history as a single ComplexAction.
+ */
+struct CableBatch
+{
+    struct Connection
+    {
+        rack::Module *inModule{nullptr};
+        int inId{-1};
+        rack::Module *outModule{nullptr};
+        int outId{-1};
+        std::optional<NVGcolor> color{std::nullopt};
+    };
+    std::vector<Connection> toAdd;
+    std::vector<rack::engine::Cable *> toRemove;
+
+    void add(rack::Module *inModule, int inId, rack::Module *outModule, int outId,
+             std::optional<NVGcolor> color = std::nullopt)
+    {
+        toAdd.push_back({inModule, inId, outModule, outId, color});
+    }
+
+    void remove(rack::engine::Cable *cable)
+    {
+        if (cable)
+            toRemove.push_back(cable);
+    }
+
+    bool isInputUsed(rack::Module *m, int inId) const
+    {
+        for (const auto &c : toAdd)
+            if (c.inModule == m && c.inId == inId)
+                return true;
+        return false;
+    }
+
+    bool empty() const { return toAdd.empty() && toRemove.empty(); }
+
+    void apply(NVGcolor col, const std::string &name)
+    {
+        if (empty())
+            return;
+
+        std::vector<patch_plan::Route> routes;
+        std::vector<NVGcolor> colors;
+        routes.reserve(toAdd.size());
+        colors.reserve(toAdd.size());
+        for (const auto &c : toAdd)
+        {
+            routes.push_back({c.outModule->id, c.outId, c.inModule->id, c.inId});
+            colors.push_back(c.color.value_or(col));
+        }
+
+        // Do every lookup, allocation and history record before the first removal so
+        // the removals and engine additions below run back to back.
+        auto routing = prepareRoutes(routes);
+
+        rack::history::ComplexAction *complexAction = new rack::history::ComplexAction;
+        complexAction->name = name;
+
+        std::vector<rack::app::CableWidget *> removeWidgets;
+        removeWidgets.reserve(toRemove.size());
+        for (auto cable : toRemove)
+        {
+            auto cw = APP->scene->rack->getCable(cable->id);
+            if (!cw)
+            {
+                // Cables added with addRoutesToEngine may not have a widget yet. Give them
+                // one so the removal is recorded and undo restores them.
+                cw = new rack::app::CableWidget;
+                cw->setCable(cable);
+                cw->color = col;
+                APP->scene->rack->addCable(cw);
+            }
+            rack::history::CableRemove *hcr = new rack::history::CableRemove;
+            hcr->setCable(cw);
+            complexAction->push(hcr);
+            removeWidgets.push_back(cw);
+        }
+
+        // Removals go first since an input can only hold one cable. Deleting the
+        // widget removes the engine cable too.
+        for (auto cw : removeWidgets)
+        {
+            APP->scene->rack->removeCable(cw);
+            delete cw;
+        }
+        addPreparedRoutesToEngine(routing);
+
+        std::vector<NVGcolor> addedColors;
+        for (auto ri : routing.routeIndex)
+            addedColors.push_back(colors[ri]);
+        addCableWidgets(routing.cables, addedColors, complexAction);
+
+        APP->history->push(complexAction);
+        toAdd.clear();
+        toRemove.clear();
+    }
+};
+
 inline void addOutputConnector(rack::Menu *menu, rack::Module *m, std::pair<int, int> cto,
                                rack::Module *source, int portL, int portR)
 {
@@ -531,6 +740,385 @@ inline void connectOutputToInRowInputs(rack::Menu *menu, rack::Module *me, int p
     }
 }
 
+/*
+ * Returns the selected modules which implement NeighborConnectable_V1, sorted
+ * by row and then left to right within a row.
+ */
+inline std::vector<rack::Module *> findSelectedNeighborConnectables()
+{
+    std::map<std::pair<float, float>, rack::Module *> modMap; // to sort it by (ypos, xpos)
+    std::vector<rack::Module *> result;
+    for (auto wid : APP->scene->rack->getSelected())
+    {
+        if (!wid || !wid->module)
+            continue;
+        if (dynamic_cast<NeighborConnectable_V1 *>(wid->module))
+            modMap[{wid->box.pos.y, wid->box.pos.x}] = wid->module;
+    }
+    for (const auto &[k, v] : modMap)
+    {
+        result.push_back(v);
+    }
+    return result;
+}
+
+/*
+ * Connect the first primary output of each module to the first free primary input
+ * of the next one. Mono (-1) companions only get the left cable.
+ */
+inline void buildChainBetween(const std::vector<rack::Module *> &mods, CableBatch &batch)
+{
+    std::vector<rack::engine::Cable *> cables;
+    for (auto cid : APP->engine->getCableIds())
+    {
+        auto cable = APP->engine->getCable(cid);
+        if (cable && cable->inputModule && cable->outputModule)
+            cables.push_back(cable);
+    }
+
+    for (size_t i = 0; i + 1 < mods.size(); ++i)
+    {
+        auto me = mods[i];
+        auto neighbor = mods[i + 1];
+        auto meNC = dynamic_cast<NeighborConnectable_V1 *>(me);
+        auto neighNC = dynamic_cast<NeighborConnectable_V1 *>(neighbor);
+        if (!meNC || !neighNC)
+            continue;
+
+        auto meOutVec = meNC->getPrimaryOutputs();
+        auto neInVec = neighNC->getPrimaryInputs();
+        if (!meOutVec.has_value() || !neInVec.has_value())
+            continue;
+        if (meOutVec->empty() || neInVec->empty())
+            continue;
+
+        const auto &meOut = meOutVec->front().second;
+        if (meOut.first < 0)
+            continue;
+
+        // Skip links which are already wired so running the action twice doesn't
+        // add a parallel cable into the next free input
+        auto alreadyChained = std::any_of(cables.begin(), cables.end(), [&](auto *c) {
+            if (c->outputModule != me || c->inputModule != neighbor)
+                return false;
+            if (c->outputId != meOut.first && !(meOut.second >= 0 && c->outputId == meOut.second))
+                return false;
+            for (const auto &[ilab, neIn] : *neInVec)
+                if ((neIn.first >= 0 && c->inputId == neIn.first) ||
+                    (neIn.second >= 0 && c->inputId == neIn.second))
+                    return true;
+            return false;
+        });
+        if (alreadyChained)
+            continue;
+
+        for (const auto &[ilab, neIn] : *neInVec)
+        {
+            auto inUse = [&](int id) {
+                return id >= 0 &&
+                       (neighbor->inputs[id].isConnected() || batch.isInputUsed(neighbor, id));
+            };
+            if (neIn.first < 0 || inUse(neIn.first) || inUse(neIn.second))
+                continue;
+
+            batch.add(neighbor, neIn.first, me, meOut.first);
+            if (neIn.second >= 0 && meOut.second >= 0)
+                batch.add(neighbor, neIn.second, me, meOut.second);
+            break;
+        }
+    }
+}
+
+inline void addChainSelectedModulesMenu(rack::Menu *menu)
+{
+    auto mods = findSelectedNeighborConnectables();
+    if (mods.size() < 2)
+        return;
+
+    menu->addChild(new rack::MenuSeparator());
+    menu->addChild(MultiColorMenuItem::create(
+        "Chain " + std::to_string(mods.size()) + " Selected Modules", "",
+        [mods](const auto &cableColor) {
+            CableBatch batch;
+            buildChainBetween(mods, batch);
+            batch.apply(cableColor, "chain selected modules");
+        }));
+}
+
+/*
+ * If 'me' sits between a left and right neighbor which are cabled primary output to
+ * primary input, replace those cables with left -> me -> right. Returns false and
+ * leaves the batch alone if there is nothing to insert into.
+ */
+inline bool buildInsertIntoChain(rack::Module *me, CableBatch &batch)
+{
+    auto left = me->getLeftExpander().module;
+    auto right = me->getRightExpander().module;
+    auto meNC = dynamic_cast<NeighborConnectable_V1 *>(me);
+    auto leftNC = dynamic_cast<NeighborConnectable_V1 *>(left);
+    auto rightNC = dynamic_cast<NeighborConnectable_V1 *>(right);
+    if (!meNC || !leftNC || !rightNC)
+        return false;
+
+    auto meInVec = meNC->getPrimaryInputs();
+    auto meOutVec = meNC->getPrimaryOutputs();
+    auto leftOutVec = leftNC->getPrimaryOutputs();
+    auto rightInVec = rightNC->getPrimaryInputs();
+    if (!meInVec.has_value() || !meOutVec.has_value() || !leftOutVec.has_value() ||
+        !rightInVec.has_value())
+        return false;
+    if (meInVec->empty() || meOutVec->empty())
+        return false;
+
+    const auto &meOut = meOutVec->front().second;
+    std::optional<std::pair<int, int>> meIn;
+    for (const auto &[ilab, in] : *meInVec)
+    {
+        if (in.first >= 0 && !me->inputs[in.first].isConnected() &&
+            (in.second < 0 || !me->inputs[in.second].isConnected()))
+        {
+            meIn = in;
+            break;
+        }
+    }
+    if (!meIn.has_value() || meOut.first < 0)
+        return false;
+
+    auto isPrimaryIn = [&](int id) {
+        for (const auto &[ilab, in] : *rightInVec)
+            if (id >= 0 && (id == in.first || id == in.second))
+                return true;
+        return false;
+    };
+
+    for (const auto &[olab, lOut] : *leftOutVec)
+    {
+        std::vector<rack::engine::Cable *> existing;
+        for (auto cid : APP->engine->getCableIds())
+        {
+            auto cable = APP->engine->getCable(cid);
+            if (cable && cable->outputModule == left && cable->inputModule == right &&
+                (cable->outputId == lOut.first ||
+                 (lOut.second >= 0 && cable->outputId == lOut.second)) &&
+                isPrimaryIn(cable->inputId))
+            {
+                existing.push_back(cable);
+            }
+        }
+        if (existing.empty())
+            continue;
+
+        auto colorOf = [](rack::engine::Cable *c) -> std::optional<NVGcolor> {
+            auto cw = APP->scene->rack->getCable(c->id);
+            if (cw)
+                return cw->color;
+            return std::nullopt;
+        };
+
+        // Only feed the new module from the left outputs which were actually cabled
+        bool usesFirst{false}, usesSecond{false};
+        for (auto c : existing)
+        {
+            usesFirst = usesFirst || c->outputId == lOut.first;
+            usesSecond = usesSecond || (lOut.second >= 0 && c->outputId == lOut.second);
+        }
+
+        auto col = colorOf(existing.front());
+        if (usesFirst)
+            batch.add(me, meIn->first, left, lOut.first, col);
+        if (usesSecond && meIn->second >= 0)
+            batch.add(me, meIn->second, left, lOut.second, col);
+        else if (usesSecond && !usesFirst)
+            batch.add(me, meIn->first, left, lOut.second, col);
+
+        for (auto c : existing)
+        {
+            auto src = meOut.first;
+            if (c->outputId == lOut.second && meOut.second >= 0)
+                src = meOut.second;
+            batch.remove(c);
+            batch.add(right, c->inputId, me, src, colorOf(c));
+        }
+        return true;
+    }
+    return false;
+}
+
+inline void addInsertIntoChainMenu(rack::Menu *menu, rack::Module *me)
+{
+    CableBatch probe;
+    if (!buildInsertIntoChain(me, probe))
+        return;
+
+    auto left = me->getLeftExpander().module;
+    auto right = me->getRightExpander().module;
+    menu->addChild(new rack::MenuSeparator());
+    menu->addChild(rack::createMenuItem(
+        "Insert Between " + left->getModel()->name + " and " + right->getModel()->name, "",
+        [me]() {
+            CableBatch batch;
+            if (buildInsertIntoChain(me, batch))
+                batch.apply(APP->scene->rack->getNextCableColor(), "insert into chain");
+        }));
+}
+
+/*
+ * A bundle is two or more mono cables running from the same output module to the
+ * same input module. If both ends implement NeighborConnectable_V2 and offer a
+ * polyphonic port for the mono ports in the bundle, it folds into a single cable.
+ */
+struct ParallelCableBundle
+{
+    rack::Module *outModule{nullptr};
+    rack::Module *inModule{nullptr};
+    std::vector<rack::engine::Cable *> cables; // sorted by output id, so channel order
+    std::optional<int> polyOutput{std::nullopt};
+    std::optional<int> polyInput{std::nullopt};
+
+    bool canFold() const { return polyOutput.has_value() && polyInput.has_value(); }
+    int cablesSaved() const { return canFold() ? (int)cables.size() - 1 : 0; }
+};
+
+struct CableConsolidationReport
+{
+    std::vector<ParallelCableBundle> bundles;
+    int totalCables{0};
+    int cablesInBundles{0};
+    int cablesSaved{0};
+
+    // The engine steps each cable once per sample, so folding k mono cables into
+    // one poly cable saves k-1 cable steps per sample. The voltages copied stay the same.
+    int cableStepsSavedPerSample() const { return cablesSaved; }
+    double cableStepsSavedPerSecond() const
+    {
+        return cablesSaved * (double)APP->engine->getSampleRate();
+    }
+};
+
+inline CableConsolidationReport findParallelCableBundles()
+{
+    CableConsolidationReport result;
+
+    std::map<std::pair<int64_t, int64_t>, ParallelCableBundle> bundleMap;
+    for (auto cid : APP->engine->getCableIds())
+    {
+        auto cable = APP->engine->getCable(cid);
+        if (!cable || !cable->outputModule || !cable->inputModule)
+            continue;
+        result.totalCables++;
+
+        if (cable->outputModule->outputs[cable->outputId].getChannels() > 1)
+            continue;
+
+        auto &b = bundleMap[{cable->outputModule->id, cable->inputModule->id}];
+        b.outModule = cable->outputModule;
+        b.inModule = cable->inputModule;
+        b.cables.push_back(cable);
+    }
+
+    std::set<std::pair<int64_t, int>> claimedInputs;
+    for (auto &[k, b] : bundleMap)
+    {
+        if (b.cables.size() < 2 || (int)b.cables.size() > rack::engine::PORT_MAX_CHANNELS)
+            continue;
+
+        std::sort(b.cables.begin(), b.cables.end(), [](auto *a, auto *c) {
+            return a->outputId < c->outputId ||
+                   (a->outputId == c->outputId && a->inputId < c->inputId);
+        });
+
+        std::vector<int> outs, ins;
+        for (auto c : b.cables)
+        {
+            outs.push_back(c->outputId);
+            ins.push_back(c->inputId);
+        }
+
+        auto outNC = dynamic_cast<NeighborConnectable_V2 *>(b.outModule);
+        auto inNC = dynamic_cast<NeighborConnectable_V2 *>(b.inModule);
+        if (outNC)
+            b.polyOutput = outNC->getPolyphonicOutputFor(outs);
+        if (inNC)
+            b.polyInput = inNC->getPolyphonicInputFor(ins);
+
+        // Don't trust the interface with our indexing
+        if (b.polyOutput.has_value() &&
+            (*b.polyOutput < 0 || *b.polyOutput >= (int)b.outModule->outputs.size()))
+            b.polyOutput = std::nullopt;
+        if (b.polyInput.has_value() &&
+            (*b.polyInput < 0 || *b.polyInput >= (int)b.inModule->inputs.size()))
+            b.polyInput = std::nullopt;
+
+        // The poly input has to be free or be one of the inputs we are about to free up
+        if (b.polyInput.has_value() && b.inModule->inputs[*b.polyInput].isConnected() &&
+            std::find(ins.begin(), ins.end(), *b.polyInput) == ins.end())
+        {
+            b.polyInput = std::nullopt;
+        }
+
+        // and two bundles from different sources can't share one poly input
+        if (b.polyInput.has_value() && b.polyOutput.has_value() &&
+            !claimedInputs.insert({b.inModule->id, *b.polyInput}).second)
+        {
+            b.polyInput = std::nullopt;
+        }
+
+        result.cablesInBundles += b.cables.size();
+        result.cablesSaved += b.cablesSaved();
+        result.bundles.push_back(b);
+    }
+    return result;
+}
+
+inline void consolidateCableBundles(const CableConsolidationReport &report)
+{
+    CableBatch batch;
+    std::optional<NVGcolor> firstCol;
+    for (const auto &b : report.bundles)
+    {
+        if (!b.canFold() || batch.isInputUsed(b.inModule, *b.polyInput))
+            continue;
+
+        // getNextCableColor advances rack's palette, so only use it with no widget to copy
+        auto cw = APP->scene->rack->getCable(b.cables.front()->id);
+        auto col = cw ? cw->color : APP->scene->rack->getNextCableColor();
+        if (!firstCol.has_value())
+            firstCol = col;
+
+        for (auto c : b.cables)
+            batch.remove(c);
+        batch.add(b.inModule, *b.polyInput, b.outModule, *b.polyOutput, col);
+    }
+    if (!firstCol.has_value())
+        return;
+    // every connection carries its own color, so this default is never used
+    batch.apply(*firstCol, "fold parallel cables to polyphonic");
+}
+
+inline void addCableConsolidationMenu(rack::Menu *menu)
+{
+    auto report = findParallelCableBundles();
+    if (report.bundles.empty())
+        return;
+
+    menu->addChild(new rack::MenuSeparator());
+    menu->addChild(rack::createMenuLabel(
+        std::to_string(report.cablesInBundles) + " of " + std::to_string(report.totalCables) +
+        " cables run in " + std::to_string(report.bundles.size()) + " parallel bundles"));
+
+    if (report.cablesSaved == 0)
+    {
+        menu->addChild(rack::createMenuLabel("No bundle has polyphonic ports at both ends"));
+        return;
+    }
+
+    menu->addChild(rack::createMenuItem(
+        "Fold to Polyphonic Cables",
+        std::to_string(report.cablesSaved) + " fewer cables, " +
+            std::to_string(report.cableStepsSavedPerSample()) + " fewer steps/sample",
+        []() { consolidateCableBundles(findParallelCableBundles()); }));
+}
+
 template <typename T> struct PortConnectionMixin : public T
 {
     bool connectAsOutputToMixmaster{false};
@@ -559,6 +1147,11 @@ template <typename T> struct PortConnectionMixin : public T
                     connectOutputToInRowInputs(x, this->module, this->portId);
                 }));
             }
+
+            if (APP->scene->rack->isSelected(thisWid))
+                addChainSelectedModulesMenu(menu);
+
+            addInsertIntoChainMenu(menu, this->module);
         }
 
         if (connectAsOutputToMixmaster)
@@ -38,5 +38,26 @@ struct __attribute__((__visibility__("default"))) NeighborConnectable_V1
         return std::nullopt;
     }
 };
+
+struct __attribute__((__visibility__("default"))) NeighborConnectable_V2 : NeighborConnectable_V1
+{
+    /*
+     * If the mono inputs 'monoInputs' can be replaced by a single polyphonic input
+     * where channel i carries what monoInputs[i] carried, return that input.
+     */
+    virtual std::optional<int> getPolyphonicInputFor(const std::vector<int> &monoInputs)
+    {
+        return std::nullopt;
+    }
+
+    /*
+     * If this module can produce a polyphonic output where channel i carries what
+     * monoOutputs[i] carries, return that output.
+     */
+    virtual std::optional<int> getPolyphonicOutputFor(const std::vector<int> &monoOutputs)
+    {
+        return std::nullopt;
+    }
+};
 } // namespace sst::rackhelpers::module_connector
 #endif // SURGEXTRACK_NEIGHBOR_CONNECTABLE_H
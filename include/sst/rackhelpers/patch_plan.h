@@ -0,0 +1,141 @@
+/*
+ * sst-rackhelpers - a Surge Synth Team product
+ *
+ * A set of header-only utilities we use when making stuff for VCV Rack
+ *
+ * Copyright 2019 - 2023, Various authors, as described in the github
+ * transaction log.
+ *
+ * sst-rackhelpers is released under the MIT license, found in the file
+ * "LICENSE.md" in this repository.
+ *
+ * All source for sst-rackhelpers is available at
+ * https://github.com/surge-synthesizer/sst-rackhelpers
+ */
+
+#ifndef INCLUDE_SST_RACKHELPERS_PATCH_PLAN_H
+#define INCLUDE_SST_RACKHELPERS_PATCH_PLAN_H
+
+/*
+ * A PatchPlan is the routing of a patch with no reference to rack at all. Modules are
+ * stand-ins with an id and a port count, and routes are plain data. This means you can
+ * generate and validate patches headless (in a CI test for instance) and only hand
+ * them to the engine, and later the UI, using the functions in module_connector.h.
+ */
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sst::rackhelpers::patch_plan
+{
+struct ModuleStub
+{
+    int64_t id{-1};
+    int numInputs{0};
+    int numOutputs{0};
+    std::string name;
+};
+
+struct Route
+{
+    int64_t outModule{-1};
+    int outId{-1};
+    int64_t inModule{-1};
+    int inId{-1};
+};
+
+struct PatchPlan
+{
+    std::map<int64_t, ModuleStub> modules;
+    std::vector<Route> routes;
+
+    // Inputs held by cables which already exist wherever the plan will be applied.
+    // These are never freed by the plan.
+    std::set<std::pair<int64_t, int>> existingInputs;
+    // Inputs taken by a route in this plan
+    std::set<std::pair<int64_t, int>> routedInputs;
+
+    void addModule(const ModuleStub &m) { modules[m.id] = m; }
+
+    void markInputUsed(int64_t moduleId, int inId) { existingInputs.insert({moduleId, inId}); }
+
+    bool isInputUsed(int64_t moduleId, int inId) const
+    {
+        return existingInputs.find({moduleId, inId}) != existingInputs.end() ||
+               routedInputs.find({moduleId, inId}) != routedInputs.end();
+    }
+
+    bool canConnect(int64_t outModule, int outId, int64_t inModule, int inId) const
+    {
+        auto om = modules.find(outModule);
+        auto im = modules.find(inModule);
+        if (om == modules.end() || im == modules.end())
+            return false;
+        if (outId < 0 || outId >= om->second.numOutputs)
+            return false;
+        if (inId < 0 || inId >= im->second.numInputs)
+            return false;
+        return !isInputUsed(inModule, inId);
+    }
+
+    // Returns false and leaves the plan unchanged if the route is not valid
+    bool connect(int64_t outModule, int outId, int64_t inModule, int inId)
+    {
+        if (!canConnect(outModule, outId, inModule, inId))
+            return false;
+        routes.push_back({outModule, outId, inModule, inId});
+        routedInputs.insert({inModule, inId});
+        return true;
+    }
+
+    bool disconnect(int64_t inModule, int inId)
+    {
+        for (auto it = routes.begin(); it != routes.end(); ++it)
+        {
+            if (it->inModule == inModule && it->inId == inId)
+            {
+                routes.erase(it);
+                routedInputs.erase({inModule, inId});
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Checks the whole plan, for instance after editing routes directly, and returns
+     * a description of each problem. An empty result means the plan is valid.
+     */
+    std::vector<std::string> validate() const
+    {
+        std::vector<std::string> errors;
+        std::set<std::pair<int64_t, int>> seen;
+        for (const auto &r : routes)
+        {
+            auto desc = std::to_string(r.outModule) + ":" + std::to_string(r.outId) + " -> " +
+                        std::to_string(r.inModule) + ":" + std::to_string(r.inId);
+            auto om = modules.find(r.outModule);
+            auto im = modules.find(r.inModule);
+            if (om == modules.end() || im == modules.end())
+            {
+                errors.push_back(desc + " references a missing module");
+                continue;
+            }
+            if (r.outId < 0 || r.outId >= om->second.numOutputs)
+                errors.push_back(desc + " output out of range");
+            if (r.inId < 0 || r.inId >= im->second.numInputs)
+                errors.push_back(desc + " input out of range");
+            if (existingInputs.find({r.inModule, r.inId}) != existingInputs.end())
+                errors.push_back(desc + " input already has a cable");
+            else if (!seen.insert({r.inModule, r.inId}).second)
+                errors.push_back(desc + " input has more than one cable");
+        }
+        return errors;
+    }
+};
+} // namespace sst::rackhelpers::patch_plan
+#endif // INCLUDE_SST_RACKHELPERS_PATCH_PLAN_H
@@ -0,0 +1,154 @@
+/*
+ * sst-rackhelpers - a Surge Synth Team product
+ *
+ * A set of header-only utilities we use when making stuff for VCV Rack
+ *
+ * Copyright 2019 - 2023, Various authors, as described in the github
+ * transaction log.
+ *
+ * sst-rackhelpers is released under the MIT license, found in the file
+ * "LICENSE.md" in this repository.
+ *
+ * All source for sst-rackhelpers is available at
+ * https://github.com/surge-synthesizer/sst-rackhelpers
+ */
+
+#ifndef INCLUDE_SST_RACKHELPERS_TEXT_LAYOUT_H
+#define INCLUDE_SST_RACKHELPERS_TEXT_LAYOUT_H
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <tuple>
+
+namespace sst::rackhelpers::ui
+{
+/*
+ * Measuring text with nanovg shapes the whole string every time, and label heavy
+ * panels and big menus do that every frame. TextLayoutCache measures a string once
+ * per font, size and zoom and shares the result across frames and across every
+ * label with the same text.
+ *
+ * NanoVG has no way to draw a pre-shaped glyph run, so drawing still goes through
+ * nvgText, but always left aligned from a cached offset which skips the second
+ * measuring pass nvgText does for centered and right aligned text.
+ */
+struct TextLayoutCache
+{
+    struct Layout
+    {
+        float advance{0.f};
+        float bounds[4]{0.f, 0.f, 0.f, 0.f};
+    };
+
+    // fontHandle, size, zoom, text
+    typedef std::tuple<int, float, float, std::string> key_t;
+
+    static constexpr size_t maxEntries{4096};
+
+    static std::map<key_t, Layout> &cache()
+    {
+        static std::map<key_t, Layout> c;
+        return c;
+    }
+
+    static float currentZoom(NVGcontext *vg)
+    {
+        float xf[6];
+        nvgCurrentTransform(vg, xf);
+        // Quantize so tiny float noise in the transform doesn't miss the cache
+        return std::round(std::sqrt(xf[0] * xf[0] + xf[1] * xf[1]) * 64.f) / 64.f;
+    }
+
+    // Returned by value since the cache may be cleared by a later call
+    static Layout get(NVGcontext *vg, int fontHandle, float size, const std::string &text)
+    {
+        auto &c = cache();
+        auto key = key_t{fontHandle, size, currentZoom(vg), text};
+        auto it = c.find(key);
+        if (it != c.end())
+            return it->second;
+
+        if (c.size() >= maxEntries)
+            c.clear();
+
+        Layout l;
+        nvgSave(vg);
+        nvgFontFaceId(vg, fontHandle);
+        nvgFontSize(vg, size);
+        nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_BASELINE);
+        l.advance = nvgTextBounds(vg, 0, 0, text.c_str(), nullptr, l.bounds);
+        nvgRestore(vg);
+        return c.emplace(key, l).first->second;
+    }
+
+    static void drawText(NVGcontext *vg, float x, float y, int fontHandle, float size,
+                         int align, const std::string &text)
+    {
+        if (align & NVG_ALIGN_CENTER)
+            x -= get(vg, fontHandle, size, text).advance * 0.5f;
+        else if (align & NVG_ALIGN_RIGHT)
+            x -= get(vg, fontHandle, size, text).advance;
+
+        nvgFontFaceId(vg, fontHandle);
+        nvgFontSize(vg, size);
+        nvgTextAlign(vg, NVG_ALIGN_LEFT | (align & ~(NVG_ALIGN_CENTER | NVG_ALIGN_RIGHT)));
+        nvgText(vg, x, y, text.c_str(), nullptr);
+    }
+
+    // BND_PAD_LEFT, BND_PAD_RIGHT, BND_LABEL_FONT_SIZE and the label baseline
+    // (BND_WIDGET_HEIGHT - BND_TEXT_PAD_DOWN) from blendish
+    static constexpr float bndPadLeft{8.f}, bndPadRight{8.f}, bndLabelFontSize{13.f},
+        bndLabelBaseline{14.f};
+
+    // The same value as bndLabelWidth(vg, -1, text) using the rack ui font, but cached
+    static float labelWidth(NVGcontext *vg, const std::string &text)
+    {
+        if (text.empty())
+            return bndPadLeft + bndPadRight;
+        return bndPadLeft + bndPadRight +
+               get(vg, APP->window->uiFont->handle, bndLabelFontSize, text).advance;
+    }
+
+    // Draws text where bndMenuItem / bndMenuLabel would put an icon-less label
+    static void drawBndLabel(NVGcontext *vg, const std::string &text, NVGcolor color)
+    {
+        nvgFillColor(vg, color);
+        drawText(vg, bndPadLeft, bndLabelBaseline, APP->window->uiFont->handle,
+                 bndLabelFontSize, NVG_ALIGN_LEFT | NVG_ALIGN_BASELINE, text);
+    }
+};
+
+/*
+ * A label you can keep around and draw from a BufferedDrawFunctionWidget lambda
+ * or a draw override without remeasuring.
+ */
+struct CachedTextLabel
+{
+    std::string text;
+    float size{12.f};
+    int align{NVG_ALIGN_LEFT | NVG_ALIGN_BASELINE};
+    NVGcolor color{nvgRGB(255, 255, 255)};
+    int fontHandle{-1};
+
+    CachedTextLabel() = default;
+    CachedTextLabel(const std::string &t, float sz, int al, NVGcolor col, int fh = -1)
+        : text(t), size(sz), align(al), color(col), fontHandle(fh)
+    {
+    }
+
+    int font() const { return fontHandle >= 0 ? fontHandle : APP->window->uiFont->handle; }
+
+    TextLayoutCache::Layout measure(NVGcontext *vg) const
+    {
+        return TextLayoutCache::get(vg, font(), size, text);
+    }
+
+    void draw(NVGcontext *vg, float x, float y) const
+    {
+        nvgFillColor(vg, color);
+        TextLayoutCache::drawText(vg, x, y, font(), size, align, text);
+    }
+};
+} // namespace sst::rackhelpers::ui
+#endif // INCLUDE_SST_RACKHELPERS_TEXT_LAYOUT_H
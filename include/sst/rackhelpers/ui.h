@@ -16,6 +16,18 @@
 #ifndef INCLUDE_SST_RACKHELPERS_UI_H
 #define INCLUDE_SST_RACKHELPERS_UI_H
 
+#include "mindmeld.h"
+#include "text_layout.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
 namespace sst::rackhelpers::ui
 {
 
@@ -61,6 +73,324 @@ struct BufferedDrawFunctionWidgetOnLayer : BufferedDrawFunctionWidget
     }
 };
 
+/*
+ * A panel full of BufferedDrawFunctionWidgets costs one framebuffer, one texture
+ * bind and one draw call per widget per frame. The compositor instead collects the
+ * draw functions and rasterizes them all into a single module sized framebuffer, so
+ * a panel with static labels and decorations draws as one quad.
+ *
+ * Each function draws in its own coordinate space (0,0 is the top left of its rect)
+ * and is clipped to its rect, just like it would be in its own BufferedDrawFunctionWidget.
+ * Invalidating any number of entries in a frame causes one re-render of the buffer.
+ */
+struct BufferedDrawFunctionCompositor : virtual rack::FramebufferWidget
+{
+    typedef BufferedDrawFunctionWidget::drawfn_t drawfn_t;
+    typedef size_t handle_t;
+
+    struct Entry
+    {
+        rack::Rect box;
+        drawfn_t drawf;
+        bool visible{true};
+    };
+    std::vector<Entry> entries;
+
+    struct InternalBDC : rack::TransparentWidget
+    {
+        BufferedDrawFunctionCompositor *owner{nullptr};
+        InternalBDC(rack::Rect box_, BufferedDrawFunctionCompositor *o) : owner(o) { box = box_; }
+
+        void draw(const DrawArgs &args) override { owner->drawEntries(args.vg); }
+    };
+
+    InternalBDC *kid = nullptr;
+    BufferedDrawFunctionCompositor(rack::Vec pos, rack::Vec sz)
+    {
+        box.pos = pos;
+        box.size = sz;
+        kid = new InternalBDC(rack::Rect(rack::Vec(0, 0), box.size), this);
+        addChild(kid);
+    }
+
+    // Same signature as the BufferedDrawFunctionWidget constructor to make porting easy
+    handle_t addDrawFunction(rack::Vec pos, rack::Vec sz, drawfn_t draw_)
+    {
+        entries.push_back({rack::Rect(pos, sz), draw_, true});
+        setDirty();
+        return entries.size() - 1;
+    }
+
+    void invalidate(handle_t h)
+    {
+        if (h < entries.size() && entries[h].visible)
+            setDirty();
+    }
+
+    void setVisible(handle_t h, bool v)
+    {
+        if (h >= entries.size() || entries[h].visible == v)
+            return;
+        entries[h].visible = v;
+        setDirty();
+    }
+
+    void setDrawFunction(handle_t h, drawfn_t draw_)
+    {
+        if (h >= entries.size())
+            return;
+        entries[h].drawf = draw_;
+        invalidate(h);
+    }
+
+    void drawEntries(NVGcontext *vg)
+    {
+        for (const auto &e : entries)
+        {
+            if (!e.visible || !e.drawf)
+                continue;
+            nvgSave(vg);
+            nvgTranslate(vg, e.box.pos.x, e.box.pos.y);
+            nvgScissor(vg, 0, 0, e.box.size.x, e.box.size.y);
+            e.drawf(vg);
+            nvgRestore(vg);
+        }
+    }
+};
+
+/*
+ * An overlay which shows where the CPU goes in a large patch, aggregated by rack row,
+ * by neighbor chain (modules touching side by side) and by what feeds each MixMaster
+ * channel. It samples every sampleInterval seconds with exponential smoothing and
+ * draws through a framebuffer which is only re-rendered on a sample. When hidden it
+ * neither samples nor draws.
+ *
+ * Rack does not export its module meters to plugins, so you supply cpuFn, which
+ * returns a module's load as a fraction of the realtime budget (1.0 == one core).
+ */
+struct CPUProfileOverlayWidget : rack::TransparentWidget
+{
+    typedef std::function<std::optional<float>(rack::Module *)> cpufn_t;
+    cpufn_t cpuFn;
+
+    double sampleInterval{0.5};
+    float smoothing{0.8f};
+    size_t maxEntriesPerGroup{6};
+
+    template <typename K> struct Entry
+    {
+        K key;
+        float load{0.f};
+    };
+    // Rows are keyed by their y position so adding a row doesn't shift the history
+    std::vector<Entry<float>> rows;
+    std::vector<Entry<std::string>> chains, mixerFeeds;
+
+    BufferedDrawFunctionWidget *bdw{nullptr};
+    double lastSample{-1.0};
+
+    CPUProfileOverlayWidget(rack::Vec pos, rack::Vec sz, cpufn_t cpuFn_) : cpuFn(cpuFn_)
+    {
+        box.pos = pos;
+        box.size = sz;
+        bdw = new BufferedDrawFunctionWidget(rack::Vec(0, 0), box.size,
+                                             [this](auto *vg) { drawReport(vg); });
+        addChild(bdw);
+    }
+
+    void step() override
+    {
+        if (!visible)
+            return;
+
+        auto now = rack::system::getTime();
+        if (lastSample < 0 || now - lastSample >= sampleInterval)
+        {
+            lastSample = now;
+            sample();
+            bdw->setDirty();
+        }
+        rack::TransparentWidget::step();
+    }
+
+    template <typename K>
+    void smoothInto(std::vector<Entry<K>> &target, const std::map<K, float> &current)
+    {
+        std::map<K, float> prior;
+        for (const auto &e : target)
+            prior[e.key] = e.load;
+
+        target.clear();
+        for (const auto &[k, v] : current)
+        {
+            auto p = prior.find(k);
+            auto sv = (p == prior.end()) ? v : smoothing * p->second + (1.f - smoothing) * v;
+            target.push_back({k, sv});
+        }
+        std::sort(target.begin(), target.end(),
+                  [](const auto &a, const auto &b) { return a.load > b.load; });
+    }
+
+    void sample()
+    {
+        if (!cpuFn)
+            return;
+
+        std::map<int64_t, float> load;
+        std::map<float, std::vector<rack::app::ModuleWidget *>> byRow;
+        for (auto mw : APP->scene->rack->getModules())
+        {
+            if (!mw || !mw->module)
+                continue;
+            load[mw->module->id] = cpuFn(mw->module).value_or(0.f);
+            byRow[mw->box.pos.y].push_back(mw);
+        }
+
+        // Rows
+        std::map<float, float> rowLoad;
+        for (const auto &[y, mws] : byRow)
+        {
+            float sum{0.f};
+            for (auto mw : mws)
+                sum += load[mw->module->id];
+            rowLoad[y] = sum;
+        }
+        smoothInto(rows, rowLoad);
+
+        // Neighbor chains start at a module with nothing on the left
+        std::map<std::string, float> chainLoad;
+        for (const auto &[y, mws] : byRow)
+        {
+            for (auto mw : mws)
+            {
+                auto m = mw->module;
+                if (m->getLeftExpander().module || !m->getRightExpander().module)
+                    continue;
+
+                float sum{0.f};
+                int count{0};
+                std::set<int64_t> seen;
+                for (auto c = m; c && !seen.count(c->id); c = c->getRightExpander().module)
+                {
+                    seen.insert(c->id);
+                    sum += load[c->id];
+                    count++;
+                }
+                chainLoad[m->getModel()->name + " +" + std::to_string(count - 1) + " (#" +
+                          std::to_string(m->id) + ")"] = sum;
+            }
+        }
+        smoothInto(chains, chainLoad);
+
+        // Mixer channels sum every module upstream of the channel input, once each
+        std::map<int64_t, std::vector<rack::engine::Cable *>> cablesInto;
+        for (auto cid : APP->engine->getCableIds())
+        {
+            auto cable = APP->engine->getCable(cid);
+            if (cable && cable->inputModule && cable->outputModule)
+                cablesInto[cable->inputModule->id].push_back(cable);
+        }
+
+        std::map<std::string, float> feedLoad;
+        for (auto mm : module_connector::findMixMasters())
+        {
+            auto numIn = module_connector::mixMasterNumInputs(mm);
+            for (int i = 0; i < numIn; ++i)
+            {
+                auto cto = module_connector::mixMasterInput(mm, i);
+                std::set<rack::Module *> visited;
+                std::vector<rack::Module *> todo;
+                for (auto cable : cablesInto[mm->id])
+                {
+                    if (cable->inputId == cto.first || cable->inputId == cto.second)
+                        todo.push_back(cable->outputModule);
+                }
+                if (todo.empty())
+                    continue;
+
+                float sum{0.f};
+                while (!todo.empty())
+                {
+                    auto m = todo.back();
+                    todo.pop_back();
+                    if (!m || m == mm || visited.count(m))
+                        continue;
+                    visited.insert(m);
+                    sum += load[m->id];
+                    for (auto cable : cablesInto[m->id])
+                        todo.push_back(cable->outputModule);
+                }
+                feedLoad[mm->getModel()->name + " (#" + std::to_string(mm->id) + ") ch " +
+                         std::to_string(i + 1)] = sum;
+            }
+        }
+        smoothInto(mixerFeeds, feedLoad);
+    }
+
+    void drawReport(NVGcontext *vg)
+    {
+        nvgBeginPath(vg);
+        nvgRoundedRect(vg, 0, 0, box.size.x, box.size.y, 4);
+        nvgFillColor(vg, nvgRGBA(0, 0, 0, 200));
+        nvgFill(vg);
+
+        if (!cpuFn)
+            return;
+
+        nvgFontFaceId(vg, APP->window->uiFont->handle);
+        nvgFontSize(vg, 11);
+        nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+
+        static constexpr float lineH{14};
+        float y{lineH * 0.5f + 2};
+        // Number the rows top to bottom only now, since the set of rows can change
+        std::vector<float> rowYs;
+        for (const auto &e : rows)
+            rowYs.push_back(e.key);
+        std::sort(rowYs.begin(), rowYs.end());
+        auto labelOf = [&rowYs](const auto &key) -> std::string {
+            if constexpr (std::is_same_v<std::decay_t<decltype(key)>, float>)
+            {
+                auto idx = std::lower_bound(rowYs.begin(), rowYs.end(), key) - rowYs.begin();
+                return "Row " + std::to_string(idx + 1);
+            }
+            else
+            {
+                return key;
+            }
+        };
+
+        auto drawGroup = [&](const std::string &title, const auto &es) {
+            if (es.empty())
+                return;
+            nvgFillColor(vg, nvgRGB(255, 220, 140));
+            nvgText(vg, 4, y, title.c_str(), nullptr);
+            y += lineH;
+
+            for (size_t i = 0; i < es.size() && i < maxEntriesPerGroup; ++i)
+            {
+                const auto &e = es[i];
+                auto barW = std::clamp(e.load, 0.f, 1.f) * (box.size.x - 8);
+                nvgBeginPath(vg);
+                nvgRect(vg, 4, y - lineH * 0.5f + 1, barW, lineH - 2);
+                nvgFillColor(vg, nvgRGBA(200, 60, 60, 160));
+                nvgFill(vg);
+
+                char pct[16];
+                snprintf(pct, 16, "%5.1f%% ", e.load * 100.f);
+                auto txt = std::string(pct) + labelOf(e.key);
+                nvgFillColor(vg, nvgRGB(230, 230, 230));
+                nvgText(vg, 8, y, txt.c_str(), nullptr);
+                y += lineH;
+            }
+        };
+
+        drawGroup("By Row", rows);
+        drawGroup("By Neighbor Chain", chains);
+        drawGroup("By Mixer Channel Feed", mixerFeeds);
+    }
+};
+
 } // namespace sst::rackhelpers::ui
 
 #endif // AIRWIN2RACK_UI_H
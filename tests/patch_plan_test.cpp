@@ -0,0 +1,123 @@
+/*
+ * sst-rackhelpers - a Surge Synth Team product
+ *
+ * A set of header-only utilities we use when making stuff for VCV Rack
+ *
+ * Copyright 2019 - 2023, Various authors, as described in the github
+ * transaction log.
+ *
+ * sst-rackhelpers is released under the MIT license, found in the file
+ * "LICENSE.md" in this repository.
+ *
+ * All source for sst-rackhelpers is available at
+ * https://github.com/surge-synthesizer/sst-rackhelpers
+ */
+
+/*
+ * patch_plan.h has no rack dependency, so this runs as a plain executable.
+ */
+
+#include "sst/rackhelpers/patch_plan.h"
+
+#include <cstdio>
+
+namespace pp = sst::rackhelpers::patch_plan;
+
+static int failures{0};
+
+#define CHECK(x)                                                                                   \
+    if (!(x))                                                                                      \
+    {                                                                                              \
+        fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #x);                      \
+        failures++;                                                                                \
+    }
+
+static pp::PatchPlan twoModules()
+{
+    pp::PatchPlan plan;
+    plan.addModule({1, 2, 2, "Source"});
+    plan.addModule({2, 2, 2, "Sink"});
+    return plan;
+}
+
+static void testConnect()
+{
+    auto plan = twoModules();
+    CHECK(plan.connect(1, 0, 2, 0));
+    CHECK(plan.connect(1, 0, 2, 1)); // outputs can fan out
+    CHECK(!plan.connect(1, 1, 2, 0)); // input already routed
+    CHECK(!plan.connect(1, 2, 2, 0)); // output out of range
+    CHECK(!plan.connect(1, 0, 2, -1)); // input out of range
+    CHECK(!plan.connect(3, 0, 2, 0)); // missing module
+    CHECK(plan.routes.size() == 2);
+    CHECK(plan.validate().empty());
+}
+
+static void testDisconnect()
+{
+    auto plan = twoModules();
+    plan.markInputUsed(2, 1);
+    CHECK(plan.connect(1, 0, 2, 0));
+    CHECK(plan.disconnect(2, 0));
+    CHECK(!plan.isInputUsed(2, 0));
+    CHECK(plan.connect(1, 1, 2, 0));
+
+    // An input held by an existing cable is never freed by the plan
+    CHECK(!plan.disconnect(2, 1));
+    CHECK(plan.isInputUsed(2, 1));
+    CHECK(!plan.connect(1, 0, 2, 1));
+}
+
+static void testValidate()
+{
+    auto plan = twoModules();
+    plan.markInputUsed(2, 1);
+    CHECK(plan.connect(1, 0, 2, 0));
+
+    auto dup = plan;
+    dup.routes.push_back({1, 1, 2, 0});
+    CHECK(dup.validate().size() == 1);
+
+    auto existing = plan;
+    existing.routes.push_back({1, 1, 2, 1});
+    CHECK(existing.validate().size() == 1);
+
+    auto range = plan;
+    range.routes.push_back({1, 7, 2, 9});
+    CHECK(range.validate().size() == 2);
+
+    auto missing = plan;
+    missing.routes.push_back({1, 0, 42, 0});
+    CHECK(missing.validate().size() == 1);
+}
+
+static void testManyPlans()
+{
+    // A generated chain of modules, rebuilt many times like a CI patch generator would
+    for (int p = 0; p < 1000; ++p)
+    {
+        pp::PatchPlan plan;
+        int n = 2 + p % 30;
+        for (int i = 0; i < n; ++i)
+            plan.addModule({i, 2, 2, "M"});
+        for (int i = 0; i + 1 < n; ++i)
+        {
+            CHECK(plan.connect(i, 0, i + 1, 0));
+            CHECK(plan.connect(i, 1, i + 1, 1));
+        }
+        CHECK((int)plan.routes.size() == 2 * (n - 1));
+        CHECK(plan.validate().empty());
+    }
+}
+
+int main()
+{
+    testConnect();
+    testDisconnect();
+    testValidate();
+    testManyPlans();
+
+    if (failures)
+        fprintf(stderr, "%d checks failed\n", failures);
+    return failures == 0 ? 0 : 1;
+}